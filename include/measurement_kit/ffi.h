@@ -66,6 +66,18 @@ void mk_task_interrupt(mk_task_t *task) MK_FFI_NOEXCEPT;
 /** mk_task_destroy() waits for task to complete and frees resources. */
 void mk_task_destroy(mk_task_t *task) MK_FFI_NOEXCEPT;
 
+/** mk_task_set_parallelism() sets the maximum number of tasks that may run
+ * concurrently in this process. The default is one. Values smaller than one
+ * are treated as one. */
+void mk_task_set_parallelism(int parallelism) MK_FFI_NOEXCEPT;
+
+/** mk_task_set_tag_parallelism() sets the maximum number of tasks having the
+ * specified tag (e.g. "performance") that may run concurrently. Values smaller
+ * than one remove the limit. By default, "performance" tasks are limited to
+ * one. Calling this function with a NULL tag has no effect. */
+void mk_task_set_tag_parallelism(
+        const char *tag, int parallelism) MK_FFI_NOEXCEPT;
+
 #ifdef __cplusplus
 }  // extern "C"
 
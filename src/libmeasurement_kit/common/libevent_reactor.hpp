@@ -25,12 +25,14 @@
 #include <measurement_kit/common/error.hpp>        // for mk::Error
 #include <measurement_kit/common/logger.hpp>       // for mk::warn
 #include <mutex>                                   // for std::recursive_mutex
+#include <vector>                                  // for std::vector
 #include <signal.h>                                // for sigaction
 #include <stdexcept>                               // for std::runtime_error
 #include <utility>                                 // for std::move
 
 extern "C" {
 static inline void mk_pollfd_cb(evutil_socket_t, short, void *);
+static inline void mk_event_cb(evutil_socket_t, short, void *);
 }
 
 namespace mk {
@@ -45,6 +47,27 @@ class EventBaseDeleter {
     }
 };
 
+// Deleter for an event pointer.
+class EventDeleter {
+  public:
+    void operator()(event *ev) {
+        if (ev != nullptr) {
+            event_free(ev);
+        }
+    }
+};
+
+// Record passed as opaque pointer to event_base_once(). Only one of the
+// callbacks is set, depending on the API that was used, such that we do
+// not need to wrap the user callback in another heap allocated callback.
+// Callbacks are always moved into and out of records, never copied.
+class PollfdRecord {
+  public:
+    Callback<> on_timeout;           // set by call_later()
+    Callback<Error> on_ready;        // set by pollin_once(), pollout_once()
+    Callback<Error, short> on_event; // set by pollfd()
+};
+
 // LibeventReactor is an mk::Reactor implementation using libevent.
 //
 // The current implementation as of 2017-11-01 does not need to be explicitly
@@ -94,14 +117,49 @@ class LibeventReactor : public Reactor, public NonCopyable, public NonMovable {
         if (evbase.get() == nullptr) {
             throw std::runtime_error("event_base_new");
         }
+        // The keepalive event keeps the loop alive while background threads
+        // are running or there are holds. Its timeout is just a safety net:
+        // the worker and release() activate it as soon as we're not busy.
+        keepalive_cb = [this]() {
+            if (!busy()) {
+                (void)event_del(keepalive.get());
+            }
+        };
+        keepalive.reset(event_new(evbase.get(), -1, EV_PERSIST,
+                mk_event_cb, &keepalive_cb));
+        if (keepalive.get() == nullptr) {
+            throw std::runtime_error("event_new");
+        }
+        // The call soon event runs all the callbacks scheduled with
+        // call_soon() since its previous run in a single batch.
+        call_soon_cb = [this]() { call_soon_drain(); };
+        call_soon_event.reset(event_new(
+                evbase.get(), -1, 0, mk_event_cb, &call_soon_cb));
+        if (call_soon_event.get() == nullptr) {
+            throw std::runtime_error("event_new");
+        }
+        worker.on_empty([ev = keepalive.get()]() {
+            event_active(ev, EV_TIMEOUT, 0);
+        });
     }
 
-    ~LibeventReactor() override {}
+    ~LibeventReactor() override {
+        // Make sure no background thread can touch `keepalive` anymore.
+        worker.on_empty({});
+    }
 
     // ## Event loop management
 
     event_base *get_event_base() override { return evbase.get(); }
 
+    void hold() override { holds.fetch_add(1); }
+
+    void release() override {
+        if (holds.fetch_sub(1) <= 1) {
+            event_active(keepalive.get(), EV_TIMEOUT, 0);
+        }
+    }
+
     void run() override {
         do {
             auto ev_status = event_base_dispatch(evbase.get());
@@ -115,18 +173,28 @@ class LibeventReactor : public Reactor, public NonCopyable, public NonMovable {
                 of now, mostly used to perform DNS queries with getaddrinfo(),
                 which is blocking. If there are threads running, treat them
                 like pending events, even though they are not managed by
-                libevent, and continue running the loop. To avoid spawning
-                and to be sure we're ready to deal /pronto/ with any upcoming
-                libevent event, schedule a call for the near future so to
-                keep the libevent loop active, and ready to react.
+                libevent, and continue running the loop. The same applies
+                when someone holds the reactor (see hold()). To this end, add
+                the keepalive event, which the worker will make active as
+                soon as the last pending task has completed, and release()
+                as soon as the last hold has been released. Its callback
+                will then remove it, thus letting the loop exit without
+                polling if there is nothing else to do.
 
                 The exact possible values for `ev_status` are -1, 0, and +1, but
                 I have coded more broad checks for robustness.
             */
-            if (ev_status > 0 && worker.concurrency() <= 0) {
+            if (ev_status > 0 && !busy()) {
                 break;
             }
-            call_later(0.250, []() {});
+            timeval tv{};
+            if (event_add(keepalive.get(),
+                        timeval_init(&tv, keepalive_timeout)) != 0) {
+                throw std::runtime_error("event_add");
+            }
+            // Also check immediately, in case the tasks completed before we
+            // added the event, or we are here because of stop().
+            event_active(keepalive.get(), EV_TIMEOUT, 0);
         } while (true);
     }
 
@@ -142,56 +210,100 @@ class LibeventReactor : public Reactor, public NonCopyable, public NonMovable {
         worker.call_in_thread(logger, std::move(cb));
     }
 
-    void call_soon(Callback<> &&cb) override { call_later(0.0, std::move(cb)); }
+    void call_soon(Callback<> &&cb) override {
+        bool was_empty = false;
+        {
+            std::unique_lock<std::mutex> _{call_soon_mutex};
+            was_empty = call_soon_queue.empty();
+            call_soon_queue.push_back(std::move(cb));
+        }
+        // Activating the event also wakes up the loop if we're running in a
+        // background thread. When the queue was not empty, the event was
+        // already active and will run this callback as well.
+        if (was_empty) {
+            event_active(call_soon_event.get(), EV_TIMEOUT, 0);
+        }
+    }
 
     void call_later(double delay, Callback<> &&cb) override {
+        auto rec = new PollfdRecord;
+        rec->on_timeout = std::move(cb);
         // Note: according to libevent documentation, it is not necessary to
         // pass `EV_TIMEOUT` to get a timeout. But I find passing it more clear.
-        pollfd(-1, EV_TIMEOUT, delay, [cb = std::move(cb)](Error, short) {
-            cb();
-        });
+        schedule(-1, EV_TIMEOUT, delay, rec);
     }
 
     // ## Poll sockets
 
     void pollin_once(socket_t fd, double timeo, Callback<Error> &&cb) override {
-        pollfd(fd, EV_READ, timeo, [cb = std::move(cb)](Error err, short) {
-            cb(std::move(err));
-        });
+        auto rec = new PollfdRecord;
+        rec->on_ready = std::move(cb);
+        schedule(fd, EV_READ, timeo, rec);
     }
 
     void pollout_once(
             socket_t fd, double timeo, Callback<Error> &&cb) override {
-        pollfd(fd, EV_WRITE, timeo, [cb = std::move(cb)](Error err, short) {
-            cb(std::move(err));
-        });
+        auto rec = new PollfdRecord;
+        rec->on_ready = std::move(cb);
+        schedule(fd, EV_WRITE, timeo, rec);
     }
 
     // ## Internals
 
     void pollfd(socket_t sockfd, short evflags, double timeout,
             Callback<Error, short> &&callback) {
+        auto rec = new PollfdRecord;
+        rec->on_event = std::move(callback);
+        schedule(sockfd, evflags, timeout, rec);
+    }
+
+    void schedule(socket_t sockfd, short evflags, double timeout,
+            PollfdRecord *rec) {
         timeval tv{};
-        auto cbp = new Callback<Error, short>(callback);
-        if (event_base_once(evbase.get(), sockfd, evflags, mk_pollfd_cb, cbp,
+        if (event_base_once(evbase.get(), sockfd, evflags, mk_pollfd_cb, rec,
                     timeval_init(&tv, timeout)) != 0) {
-            delete cbp;
+            delete rec;
             throw std::runtime_error("event_base_once");
         }
     }
 
     static void pollfd_cb(short evflags, void *opaque) {
-        auto cbp = static_cast<mk::Callback<mk::Error, short> *>(opaque);
+        auto rec = static_cast<PollfdRecord *>(opaque);
         mk::Error err = mk::NoError();
         assert((evflags & (~(EV_TIMEOUT | EV_READ | EV_WRITE))) == 0);
         if ((evflags & EV_TIMEOUT) != 0) {
             err = mk::TimeoutError();
         }
-        // In case of exception here, the stack is going to unwind, tearing down
-        // the libevent loop and leaking forever `cbp` and the event once that
-        // was used to invoke this callback.
-        (*cbp)(std::move(err), evflags);
-        delete cbp;
+        // Move the callbacks out of the record and free it before calling
+        // them, so that in case of exception here, we do not leak the
+        // record (the event once is leaked, as before).
+        auto on_timeout = std::move(rec->on_timeout);
+        auto on_ready = std::move(rec->on_ready);
+        auto on_event = std::move(rec->on_event);
+        delete rec;
+        if (on_timeout) {
+            on_timeout();
+        } else if (on_ready) {
+            on_ready(std::move(err));
+        } else if (on_event) {
+            on_event(std::move(err), evflags);
+        }
+    }
+
+    void call_soon_drain() {
+        // Swapping vectors means that, once warmed up, neither the queue nor
+        // the batch need to allocate. Callbacks scheduled while we run the
+        // batch will be run by the next loop iteration, so that I/O events
+        // are not starved by a callback that keeps rescheduling itself.
+        call_soon_batch.clear();
+        {
+            std::unique_lock<std::mutex> _{call_soon_mutex};
+            std::swap(call_soon_batch, call_soon_queue);
+        }
+        for (auto &cb : call_soon_batch) {
+            cb();
+        }
+        call_soon_batch.clear();
     }
 
     // ## Data usage
@@ -202,9 +314,20 @@ class LibeventReactor : public Reactor, public NonCopyable, public NonMovable {
     }
 
   private:
+    bool busy() { return worker.pending() > 0 || holds.load() > 0; }
+
     // ## Private attributes
 
     UniquePtr<event_base, EventBaseDeleter> evbase;
+    std::vector<Callback<>> call_soon_batch;
+    Callback<> call_soon_cb;
+    UniquePtr<event, EventDeleter> call_soon_event;
+    std::mutex call_soon_mutex;
+    std::vector<Callback<>> call_soon_queue;
+    Callback<> keepalive_cb;
+    UniquePtr<event, EventDeleter> keepalive;
+    static constexpr double keepalive_timeout = 10.0;
+    std::atomic<int64_t> holds{0};
     std::recursive_mutex data_usage_mutex;
     DataUsage data_usage;
     Worker worker;
@@ -217,4 +340,8 @@ class LibeventReactor : public Reactor, public NonCopyable, public NonMovable {
 static inline void mk_pollfd_cb(evutil_socket_t, short evflags, void *opaque) {
     mk::LibeventReactor<>::pollfd_cb(evflags, opaque);
 }
+
+static inline void mk_event_cb(evutil_socket_t, short, void *opaque) {
+    (*static_cast<mk::Callback<> *>(opaque))();
+}
 #endif
@@ -54,8 +54,8 @@ class Reactor {
     /// inside a background thread created on demand. A maximum
     /// of three such threads can be active at any time. Additionally
     /// scheduled callback will wait for a thread to be ready to
-    /// serve them. When there are no further callbacks to execute,
-    /// background threads will exit, to save resources.
+    /// serve them. Threads are reused across callbacks and exit
+    /// after they have been idle for a few seconds, to save resources.
     ///
     /// The \p logger parameter is the logger to be used.
     ///
@@ -119,6 +119,17 @@ class Reactor {
     /// libevent API.
     virtual event_base *get_event_base() = 0;
 
+    /// \brief `hold()` prevents run() from returning, even if there are no
+    /// pending events, until a matching call to release(). This allows to
+    /// wait for work performed elsewhere (e.g. by a ReactorPool) that will
+    /// report back using call_soon(), without periodically waking up.
+    /// \note Both hold() and release() can be called from any thread.
+    virtual void hold() = 0;
+
+    /// `release()` undoes a previous hold(). When the last hold is released,
+    /// run() returns as soon as there is nothing else to do.
+    virtual void release() = 0;
+
     /// \brief `run_with_initial_event` is syntactic sugar for calling
     /// call_soon() immediately followed by run().
     void run_with_initial_event(Callback<> &&cb);
@@ -0,0 +1,105 @@
+// Part of Measurement Kit <https://measurement-kit.github.io/>.
+// Measurement Kit is free software under the BSD license. See AUTHORS
+// and LICENSE for more information on the copying conditions.
+
+#include "src/libmeasurement_kit/common/reactor_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace mk {
+
+ReactorPool::ReactorPool(size_t size, SharedPtr<Logger> logger)
+    : logger_{logger} {
+    if (size <= 0) {
+        size = 1;
+    }
+    try {
+        for (size_t i = 0; i < size; ++i) {
+            // Create the reactor here such that errors are reported in the
+            // calling thread rather than in the background thread. Since
+            // jobs are scheduled with call_soon(), we hold the reactor to
+            // keep it running while there are no jobs.
+            auto reactor = Reactor::make();
+            reactor->hold();
+            reactors_.push_back(reactor);
+            jobs_.push_back(0);
+            threads_.emplace_back([this, reactor]() { loop_(reactor); });
+        }
+    } catch (...) {
+        stop_();
+        throw;
+    }
+}
+
+ReactorPool::~ReactorPool() {
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cond_.wait(lock, [this]() {
+            return std::all_of(jobs_.begin(), jobs_.end(),
+                    [](size_t n) { return n == 0; });
+        });
+    }
+    stop_();
+}
+
+void ReactorPool::stop_() {
+    for (size_t i = 0; i < threads_.size(); ++i) {
+        auto reactor = reactors_[i];
+        reactor->call_soon([reactor]() { reactor->release(); });
+    }
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void ReactorPool::call_soon(Callback<SharedPtr<Reactor>, Callback<>> &&cb) {
+    size_t idx = 0;
+    {
+        std::unique_lock<std::mutex> _{mutex_};
+        idx = (size_t)(std::min_element(jobs_.begin(), jobs_.end()) -
+                       jobs_.begin());
+        jobs_[idx] += 1;
+    }
+    auto reactor = reactors_[idx];
+    auto done = [this, idx]() {
+        {
+            std::unique_lock<std::mutex> _{mutex_};
+            jobs_[idx] -= 1;
+        }
+        cond_.notify_all();
+    };
+    // Note: std::function requires a copyable callable, so we cannot move
+    // `cb` into the lambda and we use a shared pointer to avoid copying it.
+    SharedPtr<Callback<SharedPtr<Reactor>, Callback<>>> job{
+            new Callback<SharedPtr<Reactor>, Callback<>>{std::move(cb)}};
+    reactor->call_soon([reactor, job, done]() { (*job)(reactor, done); });
+}
+
+size_t ReactorPool::size() const { return threads_.size(); }
+
+size_t ReactorPool::pending() {
+    std::unique_lock<std::mutex> _{mutex_};
+    size_t count = 0;
+    for (auto n : jobs_) {
+        count += n;
+    }
+    return count;
+}
+
+void ReactorPool::loop_(SharedPtr<Reactor> reactor) {
+    // Exceptions are fatal in measurement-kit. Same as Worker, make
+    // sure they are logged using the current logger and bail.
+    try {
+        reactor->run();
+    } catch (const std::exception &exc) {
+        logger_->warn("reactor_pool: unhandled exception: %s", exc.what());
+        std::rethrow_exception(std::current_exception());
+    } catch (...) {
+        logger_->warn("reactor_pool: unhandled unknown exception");
+        std::rethrow_exception(std::current_exception());
+    }
+}
+
+} // namespace mk
@@ -0,0 +1,71 @@
+// Part of Measurement Kit <https://measurement-kit.github.io/>.
+// Measurement Kit is free software under the BSD license. See AUTHORS
+// and LICENSE for more information on the copying conditions.
+#ifndef SRC_LIBMEASUREMENT_KIT_COMMON_REACTOR_POOL_HPP
+#define SRC_LIBMEASUREMENT_KIT_COMMON_REACTOR_POOL_HPP
+
+#include <measurement_kit/common/callback.hpp>
+#include <measurement_kit/common/logger.hpp>
+#include <measurement_kit/common/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/libmeasurement_kit/common/non_copyable.hpp"
+#include "src/libmeasurement_kit/common/non_movable.hpp"
+#include "src/libmeasurement_kit/common/reactor.hpp"
+
+namespace mk {
+
+/// \brief `ReactorPool` is a set of reactors, each running in its own OS
+/// thread. This is used to spread the work of measurements taking many
+/// inputs across many cores.
+///
+/// Each job receives the reactor on which it should schedule its I/O and
+/// a callback that it MUST call once such I/O is complete. Jobs are assigned
+/// to the reactor with fewer running jobs, and each reactor runs all the
+/// jobs assigned to it concurrently, such that the number of jobs in flight
+/// does not depend on the number of reactors.
+///
+/// Jobs are not allowed to use the reactor after they have called their
+/// completion callback, therefore a job wishing to communicate results
+/// should use call_soon() on another reactor (e.g. the one that scheduled
+/// it) before calling such callback.
+class ReactorPool : public NonCopyable, public NonMovable {
+  public:
+    /// `ReactorPool()` creates a pool with \p size threads and reactors.
+    /// \throw std::exception (or a derived class) if it is not possible
+    /// to create a reactor or to start a thread.
+    ReactorPool(size_t size, SharedPtr<Logger> logger = Logger::global());
+
+    /// `~ReactorPool()` waits for running jobs to complete and then
+    /// joins all the threads.
+    /// \note Since this blocks, do not destroy the pool from an I/O thread.
+    ~ReactorPool();
+
+    /// `call_soon()` schedules \p cb to run as soon as possible in the
+    /// I/O thread of the least busy reactor in the pool.
+    void call_soon(Callback<SharedPtr<Reactor>, Callback<>> &&cb);
+
+    /// `size()` returns the number of threads (and reactors) in the pool.
+    size_t size() const;
+
+    /// `pending()` returns the number of running jobs.
+    size_t pending();
+
+  private:
+    void loop_(SharedPtr<Reactor> reactor);
+    void stop_();
+
+    std::condition_variable cond_;
+    std::vector<size_t> jobs_; // running jobs of each reactor
+    SharedPtr<Logger> logger_;
+    std::mutex mutex_;
+    std::vector<SharedPtr<Reactor>> reactors_;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace mk
+#endif
@@ -0,0 +1,115 @@
+// Part of Measurement Kit <https://measurement-kit.github.io/>.
+// Measurement Kit is free software under the BSD license. See AUTHORS
+// and LICENSE for more information on the copying conditions.
+#ifndef SRC_LIBMEASUREMENT_KIT_COMMON_SCHEDULER_HPP
+#define SRC_LIBMEASUREMENT_KIT_COMMON_SCHEDULER_HPP
+
+#include <assert.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mk {
+
+// Scheduler decides which tasks are allowed to run. By default at most one
+// task runs at any given time, like we did before. Integrators may raise the
+// global parallelism, in which case the per-tag parallelism can be used to
+// cap specific kinds of tasks (e.g. there's no point in running more than a
+// single performance test at a time since they would compete for bandwidth).
+class Scheduler {
+  public:
+    Scheduler() { tag_parallelism_["performance"] = 1; }
+
+    static Scheduler &global() {
+        static Scheduler singleton;
+        return singleton;
+    }
+
+    void acquire(const std::vector<std::string> &tags) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cond_.wait(lock, [&]() { return can_run_(tags); });
+        ++running_;
+        for (auto &tag : tags) {
+            ++tag_running_[tag];
+        }
+    }
+
+    void release(const std::vector<std::string> &tags) {
+        {
+            std::unique_lock<std::mutex> _{mutex_};
+            assert(running_ > 0);
+            --running_;
+            for (auto &tag : tags) {
+                assert(tag_running_[tag] > 0);
+                --tag_running_[tag];
+            }
+        }
+        cond_.notify_all(); // more efficient if unlocked
+    }
+
+    unsigned short parallelism() {
+        std::unique_lock<std::mutex> _{mutex_};
+        return parallelism_;
+    }
+
+    void set_parallelism(unsigned short newval) {
+        {
+            std::unique_lock<std::mutex> _{mutex_};
+            parallelism_ = (newval > 0) ? newval : 1;
+        }
+        cond_.notify_all(); // waiters may now be allowed to run
+    }
+
+    unsigned short tag_parallelism(const std::string &tag) {
+        std::unique_lock<std::mutex> _{mutex_};
+        auto it = tag_parallelism_.find(tag);
+        return (it != tag_parallelism_.end()) ? it->second : 0;
+    }
+
+    void set_tag_parallelism(const std::string &tag, unsigned short newval) {
+        {
+            std::unique_lock<std::mutex> _{mutex_};
+            if (newval == 0) {
+                tag_parallelism_.erase(tag);
+            } else {
+                tag_parallelism_[tag] = newval;
+            }
+        }
+        cond_.notify_all(); // waiters may now be allowed to run
+    }
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+    Scheduler(Scheduler &&) = delete;
+    Scheduler &operator=(Scheduler &&) = delete;
+
+    ~Scheduler() = default;
+
+  private:
+    // Must be called with the mutex held.
+    bool can_run_(const std::vector<std::string> &tags) {
+        if (running_ >= parallelism_) {
+            return false;
+        }
+        for (auto &tag : tags) {
+            auto it = tag_parallelism_.find(tag);
+            if (it != tag_parallelism_.end() && tag_running_[tag] >= it->second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::condition_variable cond_;
+    std::mutex mutex_;
+    unsigned short parallelism_ = 1;
+    unsigned short running_ = 0;
+    std::map<std::string, unsigned short> tag_parallelism_;
+    std::map<std::string, unsigned short> tag_running_;
+};
+
+} // namespace mk
+#endif
@@ -11,8 +11,9 @@
 
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
-#include <list>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -24,13 +25,28 @@ Worker::Worker() {}
 
 Worker::Worker(short p) { state->parallelism = p; }
 
+Worker::~Worker() {
+    {
+        std::unique_lock<std::mutex> _{state->mutex};
+        state->stopped = true;
+    }
+    state->cond.notify_all();
+}
+
 void Worker::call_in_thread(SharedPtr<Logger> logger, Callback<> &&func) {
     std::unique_lock<std::mutex> _{state->mutex};
 
     // Move function such that the running-in-background thread
     // has unique ownership and controls its lifecycle.
-    state->queue.push_back(std::move(func));
+    state->queue.push_back({std::move(func), std::chrono::steady_clock::now()});
 
+    // Prefer waking up an idle thread to creating a new one. Since idle
+    // threads may not have dequeued previous tasks yet, make sure that we
+    // have enough idle threads for all the queued tasks.
+    if (state->queue.size() <= state->idle) {
+        state->cond.notify_one();
+        return;
+    }
     if (state->active >= state->parallelism) {
         return;
     }
@@ -40,16 +56,35 @@ void Worker::call_in_thread(SharedPtr<Logger> logger, Callback<> &&func) {
     auto task = [S = state, logger]() {
         for (;;) {
             Callback<> func = [&]() {
-                std::unique_lock<std::mutex> _{S->mutex};
+                std::unique_lock<std::mutex> lock{S->mutex};
                 // Initialize inside the lock such that there is only
                 // one critical section in which we could be
-                if (S->queue.size() <= 0) {
-                    --S->active;
-                    return Callback<>{};
+                while (S->queue.size() <= 0) {
+                    if (S->stopped || S->reap) {
+                        --S->active;
+                        return Callback<>{};
+                    }
+                    ++S->idle;
+                    auto status = S->cond.wait_for(lock,
+                            std::chrono::duration<double>(S->idle_timeout));
+                    --S->idle;
+                    if (status == std::cv_status::timeout &&
+                            S->queue.size() <= 0 &&
+                            S->active > S->min_threads) {
+                        --S->active;
+                        return Callback<>{};
+                    }
                 }
-                auto front = S->queue.front();
+                auto front = std::move(S->queue.front());
                 S->queue.pop_front();
-                return front;
+                ++S->running;
+                std::chrono::duration<double> waited =
+                        std::chrono::steady_clock::now() - front.queued_at;
+                S->stats.wait_time += waited.count();
+                if (waited.count() > S->stats.max_wait_time) {
+                    S->stats.max_wait_time = waited.count();
+                }
+                return std::move(front.func);
             }();
             if (!func) {
                 break;
@@ -66,6 +101,14 @@ void Worker::call_in_thread(SharedPtr<Logger> logger, Callback<> &&func) {
                 logger->warn("worker: unhandled unknown exception");
                 std::rethrow_exception(std::current_exception());
             }
+            {
+                std::unique_lock<std::mutex> _{S->mutex};
+                --S->running;
+                ++S->stats.completed;
+                if (S->running <= 0 && S->queue.size() <= 0 && S->on_empty) {
+                    S->on_empty();
+                }
+            }
         }
     };
 
@@ -83,15 +126,69 @@ void Worker::set_parallelism(unsigned short newval) const {
     state->parallelism = newval;
 }
 
+unsigned short Worker::min_threads() const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    return state->min_threads;
+}
+
+void Worker::set_min_threads(unsigned short newval) const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    state->min_threads = newval;
+}
+
+double Worker::idle_timeout() const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    return state->idle_timeout;
+}
+
+void Worker::set_idle_timeout(double newval) const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    state->idle_timeout = newval;
+}
+
 unsigned short Worker::concurrency() const {
     std::unique_lock<std::mutex> _{state->mutex};
-    return state->active;
+    return state->running;
+}
+
+size_t Worker::pending() const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    return state->queue.size() + state->running;
+}
+
+Worker::Stats Worker::stats() const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    Stats stats = state->stats;
+    stats.queued = state->queue.size();
+    stats.running = state->running;
+    stats.threads = state->active;
+    return stats;
+}
+
+void Worker::on_empty(Callback<> &&cb) const {
+    std::unique_lock<std::mutex> _{state->mutex};
+    state->on_empty = std::move(cb);
 }
 
 void Worker::wait_empty_() const {
-    while (concurrency() > 0) {
+    while (pending() > 0) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
+    {
+        std::unique_lock<std::mutex> _{state->mutex};
+        state->reap = true;
+    }
+    state->cond.notify_all();
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> _{state->mutex};
+            if (state->active <= 0) {
+                state->reap = false;
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
     std::this_thread::sleep_for(std::chrono::seconds(1));
 }
 
@@ -10,8 +10,9 @@
 
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -22,28 +23,84 @@
 
 namespace mk {
 
-class Worker {
+// Worker is a pool of background threads. Threads are created on demand, up
+// to parallelism(), and are kept alive for idle_timeout() seconds after they
+// have run their last task, so that bursts of tasks (e.g. DNS queries using
+// getaddrinfo) do not pay the cost of creating a thread for each task. At
+// least min_threads() threads are kept alive once they have been created.
+class Worker : public NonCopyable, public NonMovable {
   public:
+    // Stats contains counters describing the worker activity.
+    class Stats {
+      public:
+        uint64_t completed = 0;     // tasks run so far
+        size_t queued = 0;          // tasks waiting for a thread
+        unsigned short running = 0; // tasks being run
+        unsigned short threads = 0; // alive threads (running or idle)
+        double max_wait_time = 0.0; // max seconds spent by a task in queue
+        double wait_time = 0.0;     // total seconds spent by tasks in queue
+    };
+
+    class Task {
+      public:
+        Callback<> func;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
     class State : public NonCopyable, public NonMovable {
       public:
-        unsigned short active = 0;
+        unsigned short active = 0; // alive threads
+        std::condition_variable cond;
+        unsigned short idle = 0;
+        double idle_timeout = 5.0;
+        unsigned short min_threads = 0;
         std::mutex mutex;
+        Callback<> on_empty;
         unsigned short parallelism = 3;
-        std::list<Callback<>> queue;
+        std::deque<Task> queue;
+        bool reap = false;
+        unsigned short running = 0;
+        Stats stats;
+        bool stopped = false;
     };
 
     Worker();
 
     Worker(short parallelism);
 
+    // Note: idle threads exit when the worker is destroyed, while busy
+    // threads will first drain the queue of already scheduled tasks.
+    ~Worker();
+
     void call_in_thread(SharedPtr<Logger> logger, Callback<> &&func);
 
     unsigned short parallelism() const;
 
     void set_parallelism(unsigned short newval) const;
 
+    unsigned short min_threads() const;
+
+    void set_min_threads(unsigned short newval) const;
+
+    double idle_timeout() const;
+
+    void set_idle_timeout(double newval) const;
+
+    // Returns the number of tasks that are currently running.
     unsigned short concurrency() const;
 
+    // Returns the number of tasks that are either running or queued.
+    size_t pending() const;
+
+    Stats stats() const;
+
+    // Sets the function called whenever the last pending task completes. It
+    // is called from a background thread with the internal lock held, hence
+    // it must be quick and must not call back into this worker. Pass an
+    // empty function to clear it, in which case, when this method returns,
+    // the old function is guaranteed to not be running anymore.
+    void on_empty(Callback<> &&cb) const;
+
     // Implementation note: this method is meant to be used in regress
     // tests, where we don't want the test to exit until the background
     // thread has exited, so to clear thread-local storage. Othrwise,
@@ -51,7 +108,9 @@ class Worker {
     //
     // We expect the caller to issue a blocking command using a Worker
     // and then to call this method such that we keep the main thread
-    // alive for longer, so that background threads can exit.
+    // alive for longer, so that background threads can exit. Since
+    // threads are kept alive when idle, this method tells the idle
+    // threads to exit without waiting for the idle timeout.
     //
     // Since this is meant for internal-only usage, as explained above,
     // it has been given a name terminating with `_`.
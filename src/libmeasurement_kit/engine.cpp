@@ -24,6 +24,7 @@
 #include <deque>
 #include <exception>
 #include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -32,6 +33,7 @@
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <measurement_kit/common/error.hpp>
 #include <measurement_kit/common/logger.hpp>
@@ -39,6 +41,7 @@
 #include <measurement_kit/common/shared_ptr.hpp>
 
 #include "src/libmeasurement_kit/common/reactor.hpp"
+#include "src/libmeasurement_kit/common/scheduler.hpp"
 #include "src/libmeasurement_kit/nettests/runnable.hpp"
 
 namespace mk {
@@ -48,24 +51,6 @@ namespace engine {
 //
 // Comes first because it needs more careful handling.
 
-class Semaphore {
-  public:
-    Semaphore() = default;
-
-    void acquire() { mutex_.lock(); }
-
-    void release() { mutex_.unlock(); }
-
-    Semaphore(const Semaphore &) = delete;
-    Semaphore &operator=(const Semaphore &) = delete;
-    Semaphore(Semaphore &&) = delete;
-    Semaphore &operator=(Semaphore &&) = delete;
-
-    ~Semaphore() = default;
-
-  private:
-    std::mutex mutex_;
-};
 
 class TaskImpl {
   public:
@@ -79,6 +64,7 @@ class TaskImpl {
 };
 
 static void task_run(TaskImpl *pimpl, nlohmann::json &settings);
+static std::vector<std::string> task_tags(const nlohmann::json &settings);
 static nlohmann::json possibly_validate_event(nlohmann::json &&);
 
 static void emit(TaskImpl *pimpl, nlohmann::json &&event) {
@@ -101,18 +87,18 @@ Task::Task(nlohmann::json &&settings) {
     pimpl_->thread = std::thread([this, &barrier, settings = std::move(settings)]() mutable {
         pimpl_->running = true;
         barrier.set_value();
-        static Semaphore semaphore;
+        auto tags = task_tags(settings); // used by the scheduler
         {
             nlohmann::json event;
             event["key"] = "status.queued";
             event["value"] = nlohmann::json::object();
             emit(pimpl_.get(), std::move(event));
         }
-        semaphore.acquire(); // prevent concurrent tasks
+        Scheduler::global().acquire(tags); // wait for our turn
         task_run(pimpl_.get(), settings);
         pimpl_->running = false;
-        pimpl_->cond.notify_all(); // tell the readers we're done
-        semaphore.release();       // allow another task to run
+        pimpl_->cond.notify_all();         // tell the readers we're done
+        Scheduler::global().release(tags); // allow another task to run
     });
     started.wait(); // guarantee Task() completes when the thread is running
 }
@@ -159,6 +145,23 @@ Task::~Task() {
     }
 }
 
+/*static*/ unsigned short Task::parallelism() {
+    return Scheduler::global().parallelism();
+}
+
+/*static*/ void Task::set_parallelism(unsigned short newval) {
+    Scheduler::global().set_parallelism(newval);
+}
+
+/*static*/ unsigned short Task::tag_parallelism(const std::string &tag) {
+    return Scheduler::global().tag_parallelism(tag);
+}
+
+/*static*/ void Task::set_tag_parallelism(
+        const std::string &tag, unsigned short newval) {
+    Scheduler::global().set_tag_parallelism(tag, newval);
+}
+
 // # Helpers
 
 static std::tuple<int, bool> log_level_atoi(const std::string &str) {
@@ -523,6 +526,37 @@ static std::unique_ptr<nettests::Runnable> make_runnable(const std::string &s) {
     return runnable;
 }
 
+static std::vector<std::string> task_tags(const nlohmann::json &settings) {
+    // Note: settings have not been validated yet, hence the many checks.
+    if (!settings.is_object() || settings.count("name") <= 0 ||
+            !settings.at("name").is_string()) {
+        return {};
+    }
+    auto s = settings.at("name").get<std::string>();
+    if (s == "Dash") {
+        return {"performance"};
+    }
+    if (s == "DnsInjection") {
+        return {"needs_input"};
+    }
+    if (s == "MeekFrontedRequests") {
+        return {"needs_input"};
+    }
+    if (s == "MultiNdt") {
+        return {"performance"};
+    }
+    if (s == "Ndt") {
+        return {"performance"};
+    }
+    if (s == "TcpConnect") {
+        return {"needs_input"};
+    }
+    if (s == "WebConnectivity") {
+        return {"needs_input", "websites"};
+    }
+    return {};
+}
+
 static void emit_settings_failure(TaskImpl *pimpl, const char *reason) {
     emit(pimpl, make_log_event(MK_LOG_ERR, reason));
     emit(pimpl, make_failure_event(ValueError()));
@@ -906,6 +940,30 @@ static void task_run(TaskImpl *pimpl, nlohmann::json &settings) {
                         }
                         break;
                     }
+                    if (key == "reactor_pool_max_buffered_entries") {
+                        found = true;
+                        if (!value.is_number_integer()) {
+                            std::stringstream ss;
+                            ss << "Found " << key << " option which has the "
+                               << "wrong type (fyi: it should be a "
+                               << "number_integer)";
+                            emit_settings_warning(pimpl, ss.str().data());
+                            // FALLTHROUGH
+                        }
+                        break;
+                    }
+                    if (key == "reactor_pool_size") {
+                        found = true;
+                        if (!value.is_number_integer()) {
+                            std::stringstream ss;
+                            ss << "Found " << key << " option which has the "
+                               << "wrong type (fyi: it should be a "
+                               << "number_integer)";
+                            emit_settings_warning(pimpl, ss.str().data());
+                            // FALLTHROUGH
+                        }
+                        break;
+                    }
                     if (key == "save_real_probe_asn") {
                         found = true;
                         if (!value.is_boolean()) {
@@ -5,6 +5,7 @@
 #define SRC_LIBMEASUREMENT_KIT_ENGINE_HPP
 
 #include <memory>
+#include <string>
 
 #include <measurement_kit/common/nlohmann/json.hpp>
 
@@ -20,8 +21,11 @@ class TaskImpl;
 ///
 /// Creating a Task also creates the thread that will run it. Altough you can
 /// construct more than one Task at a time, Measurement Kit will make sure that
-/// tasks do not run concurrently, even though there is no guarantee that they
-/// will actually run sequentially.
+/// no more than parallelism() tasks run concurrently, even though there is no
+/// guarantee that they will actually be started in FIFO order. The default
+/// parallelism is one, meaning that tasks do not run concurrently. In addition,
+/// tasks tagged as "performance" never run concurrently with other tasks having
+/// the same tag, unless you change that using set_tag_parallelism().
 ///
 /// A Task will emit events while running, which you can retrieve using the
 /// wait_for_next_event() call, which blocks until next event occurs. You can
@@ -55,6 +59,25 @@ class Task {
     /// ~Task() waits for the task to finish and deallocates resources.
     ~Task();
 
+    /// parallelism() returns the maximum number of tasks that may run
+    /// concurrently inside this process.
+    static unsigned short parallelism();
+
+    /// set_parallelism() sets the maximum number of tasks that may run
+    /// concurrently. Zero is treated as one. Already running tasks are
+    /// not affected when the parallelism is reduced.
+    static void set_parallelism(unsigned short newval);
+
+    /// tag_parallelism() returns the maximum number of tasks with the
+    /// specified tag (e.g. "performance") that may run concurrently, or
+    /// zero, meaning that only parallelism() applies.
+    static unsigned short tag_parallelism(const std::string &tag);
+
+    /// set_tag_parallelism() sets the maximum number of tasks with the
+    /// specified tag that may run concurrently. Zero removes the limit.
+    static void set_tag_parallelism(
+            const std::string &tag, unsigned short newval);
+
     // Implementation note: this class is _explicitly_ non copyable and non
     // movable so we don't have to worry about pimpl's validity.
     Task(const Task &) noexcept = delete;
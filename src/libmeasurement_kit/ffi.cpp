@@ -9,6 +9,7 @@
 #include <limits.h>
 #include <string.h>
 
+#include <algorithm>
 #include <exception>
 #include <string>
 
@@ -66,3 +67,23 @@ void mk_task_interrupt(mk_task_t *task) noexcept {
 void mk_task_destroy(mk_task_t *task) noexcept {
     delete task; // handles nullptr
 }
+
+static unsigned short mk_parallelism_clamp(int parallelism) noexcept {
+    return (unsigned short)std::max(0, std::min(parallelism, (int)USHRT_MAX));
+}
+
+void mk_task_set_parallelism(int parallelism) noexcept {
+    mk::engine::Task::set_parallelism(mk_parallelism_clamp(parallelism));
+}
+
+void mk_task_set_tag_parallelism(
+        const char *tag, int parallelism) noexcept {
+    if (tag != nullptr) {
+        try {
+            mk::engine::Task::set_tag_parallelism(
+                    tag, mk_parallelism_clamp(parallelism));
+        } catch (const std::exception &) {
+            // FALLTHROUGH
+        }
+    }
+}
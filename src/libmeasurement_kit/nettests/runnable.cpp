@@ -19,6 +19,9 @@
 #include <measurement_kit/vendor/mkiplookup.h>
 #include <measurement_kit/vendor/mkmmdb.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace mk {
 namespace nettests {
 
@@ -44,6 +47,101 @@ void Runnable::main(std::string, Settings, Callback<SharedPtr<nlohmann::json>> c
         [=]() { cb(SharedPtr<nlohmann::json>{new nlohmann::json}); });
 }
 void Runnable::fixup_entry(nlohmann::json &) {}
+void Runnable::main_with_reactor(SharedPtr<Reactor>, std::string input,
+        Settings options, Callback<SharedPtr<nlohmann::json>> cb) {
+    // Note: if a derived class is not able to run using a specific reactor
+    // then it should not set `supports_reactor_pool`.
+    main(input, options, cb);
+}
+
+void Runnable::start_reactor_pool() {
+    int64_t size = options.get("reactor_pool_size", (int64_t)0);
+    if (size <= 0) {
+        return;
+    }
+    if (!supports_reactor_pool) {
+        logger->debug("net_test: reactor pool not supported by this test");
+        return;
+    }
+    logger->debug("net_test: using a pool of %lld reactors", (long long)size);
+    reactor_pool.reset(new ReactorPool{(size_t)size, logger});
+}
+
+void Runnable::stop_reactor_pool(Callback<> &&cb) {
+    if (!reactor_pool) {
+        cb();
+        return;
+    }
+    // Joining the pool threads blocks, so do that in a background thread
+    // and continue in the I/O thread once done. We pass the pool using a
+    // shared slot such that it is destroyed in the background thread even
+    // if the background thread copies its callback.
+    SharedPtr<SharedPtr<ReactorPool>> pool{
+            new SharedPtr<ReactorPool>{reactor_pool}};
+    reactor_pool.reset();
+    SharedPtr<Reactor> reactor = this->reactor;
+    Callback<> done = std::move(cb);
+    reactor->call_in_thread(logger, [pool, reactor, done]() {
+        pool->reset();
+        reactor->call_soon([done]() { done(); });
+    });
+}
+
+void Runnable::write_entry_in_order(size_t idx, Callback<> &&write_entry) {
+    // Measurements run in the pool complete in any order, therefore we keep
+    // the entries that completed early until it's their turn, such that the
+    // report contains the entries in the same order as the input.
+    pool_entries[idx] = std::move(write_entry);
+    while (pool_entries.count(pool_next_entry) > 0) {
+        auto fn = std::move(pool_entries[pool_next_entry]);
+        pool_entries.erase(pool_next_entry);
+        pool_next_entry += 1;
+        fn();
+    }
+    // Resume the slots that we stopped because the buffer was full
+    while (!pool_paused_slots.empty() &&
+           pool_entries.size() < pool_max_buffered_entries) {
+        auto fn = std::move(pool_paused_slots.front());
+        pool_paused_slots.pop_front();
+        fn();
+    }
+}
+
+void Runnable::when_pool_entries_buffered(Callback<> &&cb) {
+    // While an early input is slow, the entries of the following inputs
+    // accumulate in the reorder buffer. Stop dispatching inputs when it is
+    // full, rather than letting it grow without bound. This cannot stall,
+    // because the input holding back the others is still running.
+    if (pool_entries.size() < pool_max_buffered_entries) {
+        cb();
+        return;
+    }
+    pool_paused_slots.push_back(std::move(cb));
+}
+
+void Runnable::pool_entry_written(Error error) {
+    if (error && !pool_write_error) {
+        // Stops the slots from dispatching more inputs to the pool
+        pool_write_error = error;
+    }
+    pool_pending_writes -= 1;
+    if (pool_pending_writes > 0) {
+        return;
+    }
+    auto waiting = std::move(pool_idle_slots);
+    pool_idle_slots.clear();
+    for (auto &fn : waiting) {
+        fn();
+    }
+}
+
+void Runnable::when_pool_entries_written(Callback<> &&cb) {
+    if (pool_pending_writes <= 0) {
+        cb();
+        return;
+    }
+    pool_idle_slots.push_back(std::move(cb));
+}
 
 void Runnable::run_next_measurement(size_t thread_id, Callback<Error> cb,
                                     size_t num_entries,
@@ -59,6 +157,11 @@ void Runnable::run_next_measurement(size_t thread_id, Callback<Error> cb,
         return;
     }
 
+    if (pool_write_error) {
+        cb(pool_write_error);
+        return;
+    }
+
     if (inputs.size() <= 0) {
         logger->debug("net_test: reached end of input");
         cb(NoError());
@@ -97,7 +200,10 @@ void Runnable::run_next_measurement(size_t thread_id, Callback<Error> cb,
         {"input", next_input},
     }));
 
-    main(next_input, options, [=](SharedPtr<nlohmann::json> test_keys) {
+    // Fills and writes the entry, then calls `written` with the error that
+    // should stop the measurements, if any, or NoError().
+    auto write_entry = [=](SharedPtr<nlohmann::json> test_keys,
+                           Callback<Error> written) {
         nlohmann::json entry;
         entry["input"] = next_input;
         // Make sure the input is `null` rather than empty string
@@ -160,7 +266,7 @@ void Runnable::run_next_measurement(size_t thread_id, Callback<Error> cb,
                     {"failure", error.reason},
                 });
                 if (not options.get("ignore_write_entry_error", true)) {
-                    cb(error);
+                    written(error);
                     return;
                 }
             } else {
@@ -172,10 +278,62 @@ void Runnable::run_next_measurement(size_t thread_id, Callback<Error> cb,
             logger->emit_event_ex("status.measurement_done", {
                 {"idx", saved_current_entry}
             });
+            written(NoError());
+        }, logger);
+    };
+
+    if (reactor_pool) {
+        // Run the measurement in the pool and funnel the results back to
+        // our reactor where we fill the entry and write the report. Note
+        // that we copy `options` and `reactor` in this thread because
+        // they are not thread safe and we're about to run in another one.
+        // Our reactor may have no pending events until the pool posts the
+        // results, hence we hold it until then. The slot moves on to the
+        // next input as soon as its measurement is complete, while the entry
+        // waits in the reorder buffer for the earlier ones to be written.
+        auto main_reactor = reactor;
+        auto main_options = options;
+        main_reactor->hold();
+        reactor_pool->call_soon([=](SharedPtr<Reactor> pool_reactor,
+                                        Callback<> done) {
+            main_with_reactor(pool_reactor, next_input, main_options,
+                    [=](SharedPtr<nlohmann::json> test_keys) {
+                        DataUsage du;
+                        pool_reactor->with_current_data_usage(
+                                [&](DataUsage &x) { std::swap(du, x); });
+                        main_reactor->with_current_data_usage(
+                                [&](DataUsage &x) {
+                                    x.down += du.down;
+                                    x.up += du.up;
+                                });
+                        main_reactor->call_soon([=]() {
+                            main_reactor->release();
+                            pool_pending_writes += 1;
+                            write_entry_in_order(saved_current_entry, [=]() {
+                                write_entry(test_keys, [=](Error error) {
+                                    pool_entry_written(error);
+                                });
+                            });
+                            when_pool_entries_buffered([=]() {
+                                run_next_measurement(thread_id, cb,
+                                        num_entries, current_entry);
+                            });
+                        });
+                        done();
+                    });
+        });
+        return;
+    }
+    main(next_input, options, [=](SharedPtr<nlohmann::json> test_keys) {
+        write_entry(test_keys, [=](Error error) {
+            if (error) {
+                cb(error);
+                return;
+            }
             reactor->call_soon([=]() {
                 run_next_measurement(thread_id, cb, num_entries, current_entry);
             });
-        }, logger);
+        });
     });
 }
 
@@ -468,19 +626,44 @@ void Runnable::begin(Callback<Error> cb) {
                         }
                         size_t num_entries = inputs.size();
 
-                        // Run `parallelism` measurements in parallel
+                        // Possibly spread the measurements across many
+                        // reactors (and cores) when the test allows that
+                        start_reactor_pool();
+
+                        // Run `parallelism` measurements in parallel and
+                        // by default keep all the pool reactors busy
+                        size_t parallelism = options.get("parallelism", 3);
+                        if (reactor_pool && options.count("parallelism") == 0) {
+                            parallelism = std::max(
+                                    parallelism, reactor_pool->size());
+                        }
+                        int64_t max_buffered = options.get(
+                                "reactor_pool_max_buffered_entries",
+                                (int64_t)0);
+                        pool_max_buffered_entries = std::max((size_t)1,
+                                (max_buffered > 0) ? (size_t)max_buffered
+                                                   : 4 * parallelism);
                         SharedPtr<size_t> current_entry(new size_t(0));
+                        // A slot is done once the entries that it has
+                        // measured have been written as well
+                        auto run_slot = [=](size_t thread_id,
+                                            Callback<Error> cb) {
+                            run_next_measurement(thread_id, [=](Error error) {
+                                when_pool_entries_written(
+                                        [=]() { cb(error); });
+                            }, num_entries, current_entry);
+                        };
                         mk::parallel(mk::fmap<size_t, Continuation<Error>>(
-                                         mk::range<size_t>(
-                                             options.get("parallelism", 3)),
+                                         mk::range<size_t>(parallelism),
                                          [=](size_t thread_id) {
                                              return [=](Callback<Error> cb) {
-                                                 run_next_measurement(
-                                                     thread_id, cb, num_entries,
-                                                     current_entry);
+                                                 run_slot(thread_id, cb);
                                              };
                                          }),
-                                     cb);
+                                     [=](Error error) {
+                                         stop_reactor_pool(
+                                                 [=]() { cb(error); });
+                                     });
 
                     });
                 },
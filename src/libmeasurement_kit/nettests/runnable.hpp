@@ -8,12 +8,14 @@
 #include "src/libmeasurement_kit/common/non_copyable.hpp"
 #include "src/libmeasurement_kit/common/non_movable.hpp"
 #include "src/libmeasurement_kit/common/reactor.hpp"
+#include "src/libmeasurement_kit/common/reactor_pool.hpp"
 
 #include "src/libmeasurement_kit/report/report.hpp"
 
 #include <ctime>
 #include <deque>
 #include <list>
+#include <map>
 #include <sstream>
 
 namespace mk {
@@ -38,6 +40,7 @@ class Runnable : public NonCopyable, public NonMovable {
     std::list<Delegate<>> destroy_cbs;
     bool needs_input = false;
     bool use_bouncer = true;
+    bool supports_reactor_pool = false;
     std::map<std::string, std::string> test_helpers_data;
     std::map<std::string, std::string> annotations;
     Delegate<DataUsage> data_usage_cb;
@@ -57,6 +60,11 @@ class Runnable : public NonCopyable, public NonMovable {
     virtual void main(std::string, Settings, Callback<SharedPtr<nlohmann::json>>);
     virtual void fixup_entry(nlohmann::json &);
 
+    // Functions that derived classes setting `supports_reactor_pool` MUST
+    // override to run the measurement using the specified reactor
+    virtual void main_with_reactor(SharedPtr<Reactor>, std::string, Settings,
+            Callback<SharedPtr<nlohmann::json>>);
+
     // Functions that derived classes should access
     std::list<std::string> test_helpers_option_names();
     std::list<std::string> test_helpers_bouncer_names();
@@ -65,8 +73,22 @@ class Runnable : public NonCopyable, public NonMovable {
     report::Report report;
     tm test_start_time;
     double beginning = 0.0;
+    SharedPtr<ReactorPool> reactor_pool;
+    std::map<size_t, Callback<>> pool_entries;
+    size_t pool_next_entry = 0;
+    size_t pool_pending_writes = 0;
+    Error pool_write_error = NoError();
+    std::list<Callback<>> pool_idle_slots;
+    std::list<Callback<>> pool_paused_slots;
+    size_t pool_max_buffered_entries = 0;
 
     void run_next_measurement(size_t, Callback<Error>, size_t, SharedPtr<size_t>);
+    void start_reactor_pool();
+    void stop_reactor_pool(Callback<> &&);
+    void write_entry_in_order(size_t, Callback<> &&);
+    void when_pool_entries_buffered(Callback<> &&);
+    void pool_entry_written(Error);
+    void when_pool_entries_written(Callback<> &&);
     void query_bouncer(Callback<Error>);
     void geoip_lookup(Callback<>);
     void open_report(Callback<Error>);
@@ -101,6 +123,8 @@ class WebConnectivityRunnable : public Runnable {
     WebConnectivityRunnable() noexcept;
     void main(
             std::string, Settings, Callback<SharedPtr<nlohmann::json>>) override;
+    void main_with_reactor(SharedPtr<Reactor>, std::string, Settings,
+            Callback<SharedPtr<nlohmann::json>>) override;
     void fixup_entry(nlohmann::json &) override;
 };
 
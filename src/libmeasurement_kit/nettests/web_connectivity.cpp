@@ -15,10 +15,17 @@ WebConnectivityRunnable::WebConnectivityRunnable() noexcept {
     test_version = "0.0.1";
     needs_input = true;
     test_helpers_data = {{"web-connectivity", "backend"}};
+    supports_reactor_pool = true;
 }
 
 void WebConnectivityRunnable::main(std::string input, Settings options,
                                    Callback<SharedPtr<nlohmann::json>> cb) {
+    main_with_reactor(reactor, input, options, cb);
+}
+
+void WebConnectivityRunnable::main_with_reactor(SharedPtr<Reactor> reactor,
+        std::string input, Settings options,
+        Callback<SharedPtr<nlohmann::json>> cb) {
     ooni::web_connectivity(input, options, cb, reactor, logger);
 }
 
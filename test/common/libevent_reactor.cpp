@@ -10,6 +10,10 @@
 #include "src/libmeasurement_kit/common/utils.hpp"
 #include <measurement_kit/common.hpp>
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 using namespace mk;
 
 extern "C" {
@@ -110,6 +114,42 @@ TEST_CASE("Reactor: call_later") {
     }
 }
 
+TEST_CASE("Reactor: call_soon") {
+    SECTION("Callbacks are run in FIFO order") {
+        LibeventReactor<> reactor;
+        std::vector<int> v;
+        reactor.run_with_initial_event([&]() {
+            for (int i = 0; i < 16; ++i) {
+                reactor.call_soon([&, i]() {
+                    v.push_back(i);
+                    if (i % 2 == 0) {
+                        reactor.call_soon([&, i]() { v.push_back(100 + i); });
+                    }
+                });
+            }
+        });
+        REQUIRE(v.size() == 24);
+        for (int i = 0; i < 16; ++i) {
+            REQUIRE(v[i] == i);
+        }
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(v[16 + i] == 100 + 2 * i);
+        }
+    }
+
+    SECTION("Callbacks can be scheduled from background threads") {
+        LibeventReactor<> reactor;
+        auto called = 0;
+        reactor.call_in_thread(Logger::global(), [&]() {
+            for (int i = 0; i < 16; ++i) {
+                reactor.call_soon([&]() { ++called; });
+            }
+        });
+        reactor.run();
+        REQUIRE(called == 16);
+    }
+}
+
 TEST_CASE("Reactor: pollfd") {
     SECTION("We deal with event_base_once() failure") {
         LibeventReactor<event_base_new, event_base_once_fail,
@@ -118,3 +158,61 @@ TEST_CASE("Reactor: pollfd") {
         REQUIRE_THROWS(reactor.pollfd(0, 0, 0.0, [](Error, short) {}));
     }
 }
+
+TEST_CASE("Reactor: call_in_thread") {
+    SECTION("The loop exits as soon as background threads are done") {
+        LibeventReactor<> reactor;
+        auto begin = mk::time_now();
+        reactor.call_in_thread(Logger::global(), []() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        });
+        reactor.run();
+        auto elapsed = mk::time_now() - begin;
+        REQUIRE(elapsed >= 0.1);
+        REQUIRE(elapsed < 0.2);
+    }
+
+    SECTION("The loop does not exit while background threads are running") {
+        LibeventReactor<> reactor;
+        auto called = false;
+        reactor.call_in_thread(Logger::global(), [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            reactor.call_later(0.1, [&]() { called = true; });
+        });
+        reactor.run();
+        REQUIRE(called);
+    }
+}
+
+TEST_CASE("Reactor: hold and release") {
+    SECTION("The loop does not exit while it is held") {
+        LibeventReactor<> reactor;
+        auto called = false;
+        reactor.hold();
+        std::thread thread{[&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            reactor.call_soon([&]() { called = true; });
+            reactor.release();
+        }};
+        auto begin = mk::time_now();
+        reactor.run();
+        auto elapsed = mk::time_now() - begin;
+        thread.join();
+        REQUIRE(called);
+        REQUIRE(elapsed >= 0.09); // libevent timers may fire a bit early
+        REQUIRE(elapsed < 0.2);
+    }
+
+    SECTION("The loop exits when all holds have been released") {
+        LibeventReactor<> reactor;
+        reactor.hold();
+        reactor.hold();
+        reactor.call_later(0.05, [&]() { reactor.release(); });
+        reactor.call_later(0.1, [&]() { reactor.release(); });
+        auto begin = mk::time_now();
+        reactor.run();
+        auto elapsed = mk::time_now() - begin;
+        REQUIRE(elapsed >= 0.09); // libevent timers may fire a bit early
+        REQUIRE(elapsed < 0.2);
+    }
+}
@@ -0,0 +1,86 @@
+// Part of Measurement Kit <https://measurement-kit.github.io/>.
+// Measurement Kit is free software under the BSD license. See AUTHORS
+// and LICENSE for more information on the copying conditions.
+
+#include "test/winsock.hpp"
+
+#include "include/private/catch.hpp"
+
+#include "src/libmeasurement_kit/common/reactor_pool.hpp"
+
+#include <measurement_kit/common.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+TEST_CASE("The reactor pool runs jobs on its own reactors and threads") {
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::set<mk::Reactor *> reactors;
+    std::atomic<int> count{0};
+    std::atomic<int> main_reactor_used{0};
+    auto main_reactor = mk::Reactor::make();
+    {
+        mk::ReactorPool pool{4};
+        REQUIRE(pool.size() == 4);
+        for (size_t i = 0; i < 64; ++i) {
+            pool.call_soon([&](mk::SharedPtr<mk::Reactor> reactor,
+                                   mk::Callback<> done) {
+                // Note: Catch is not thread safe, so check later
+                if (reactor.get() == main_reactor.get()) {
+                    ++main_reactor_used;
+                }
+                // Make sure I/O scheduled on the reactor is completed
+                reactor->call_later(0.01, [&, reactor, done]() {
+                    {
+                        std::unique_lock<std::mutex> _{mutex};
+                        threads.insert(std::this_thread::get_id());
+                        reactors.insert(reactor.get());
+                        ++count;
+                    }
+                    done();
+                });
+            });
+        }
+    } // Destructor waits for all the jobs to complete
+    REQUIRE(count == 64);
+    REQUIRE(main_reactor_used == 0);
+    REQUIRE(threads.size() <= 4);
+    REQUIRE(reactors.size() <= 4);
+    REQUIRE(threads.count(std::this_thread::get_id()) == 0);
+}
+
+TEST_CASE("Each reactor of the pool runs many jobs concurrently") {
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    {
+        mk::ReactorPool pool{2};
+        for (size_t i = 0; i < 8; ++i) {
+            pool.call_soon([&](mk::SharedPtr<mk::Reactor> reactor,
+                                   mk::Callback<> done) {
+                int now = ++running;
+                int prev = max_running.load();
+                while (now > prev && !max_running.compare_exchange_weak(
+                                             prev, now)) {
+                    /* nothing */;
+                }
+                reactor->call_later(0.25, [&, done]() {
+                    --running;
+                    done();
+                });
+            });
+        }
+        REQUIRE(pool.pending() <= 8);
+    }
+    // With jobs run one after the other we would see at most two
+    REQUIRE(max_running == 8);
+    REQUIRE(running == 0);
+}
+
+TEST_CASE("The reactor pool creates at least one thread") {
+    mk::ReactorPool pool{0};
+    REQUIRE(pool.size() == 1);
+    REQUIRE(pool.pending() == 0);
+}
@@ -0,0 +1,123 @@
+// Part of Measurement Kit <https://measurement-kit.github.io/>.
+// Measurement Kit is free software under the BSD license. See AUTHORS
+// and LICENSE for more information on the copying conditions.
+
+#include "include/private/catch.hpp"
+
+#include "src/libmeasurement_kit/common/scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs jobs with the specified tags, each of which blocks until all the
+// jobs that may run concurrently are running, and keeps track of the
+// maximum number of jobs, and of jobs with `tag`, running at once.
+class BlockingJobs {
+  public:
+    std::condition_variable cond;
+    bool gate_open = false;
+    int max_running = 0;
+    int max_running_tag = 0;
+    std::mutex mutex;
+    int running = 0;
+    int running_tag = 0;
+    std::string tag;
+    std::vector<std::thread> threads;
+
+    void start(mk::Scheduler &scheduler, std::vector<std::string> tags) {
+        threads.emplace_back([this, &scheduler, tags]() {
+            scheduler.acquire(tags);
+            bool tagged = std::find(tags.begin(), tags.end(), tag) != tags.end();
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                running += 1;
+                running_tag += tagged ? 1 : 0;
+                max_running = std::max(max_running, running);
+                max_running_tag = std::max(max_running_tag, running_tag);
+                cond.notify_all();
+                cond.wait(lock, [this]() { return gate_open; });
+                running -= 1;
+                running_tag -= tagged ? 1 : 0;
+            }
+            scheduler.release(tags);
+        });
+    }
+
+    // Waits until `count` jobs are running, then gives the others some time
+    // to (wrongly) start before letting all the jobs complete.
+    void run(int count) {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            REQUIRE(cond.wait_for(lock, std::chrono::seconds(10),
+                    [&]() { return running >= count; }));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        {
+            std::unique_lock<std::mutex> _{mutex};
+            gate_open = true;
+        }
+        cond.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+TEST_CASE("Scheduler runs one job at a time by default") {
+    mk::Scheduler scheduler;
+    BlockingJobs jobs;
+    REQUIRE(scheduler.parallelism() == 1);
+    for (int i = 0; i < 4; ++i) {
+        jobs.start(scheduler, {});
+    }
+    jobs.run(1);
+    REQUIRE(jobs.max_running == 1);
+}
+
+TEST_CASE("Scheduler honours the global parallelism") {
+    mk::Scheduler scheduler;
+    BlockingJobs jobs;
+    scheduler.set_parallelism(3);
+    for (int i = 0; i < 8; ++i) {
+        jobs.start(scheduler, {});
+    }
+    jobs.run(3);
+    REQUIRE(jobs.max_running == 3);
+}
+
+TEST_CASE("Scheduler honours the per tag parallelism") {
+    mk::Scheduler scheduler;
+    BlockingJobs jobs;
+    jobs.tag = "web";
+    scheduler.set_parallelism(8);
+    scheduler.set_tag_parallelism("web", 2);
+    REQUIRE(scheduler.tag_parallelism("web") == 2);
+    for (int i = 0; i < 6; ++i) {
+        jobs.start(scheduler, {"web"});
+    }
+    for (int i = 0; i < 2; ++i) {
+        jobs.start(scheduler, {"other"});
+    }
+    // Untagged jobs must not be held back by the tagged ones
+    jobs.run(4);
+    REQUIRE(jobs.max_running_tag == 2);
+    REQUIRE(jobs.max_running == 4);
+}
+
+TEST_CASE("Scheduler runs a single performance job by default") {
+    mk::Scheduler scheduler;
+    BlockingJobs jobs;
+    jobs.tag = "performance";
+    scheduler.set_parallelism(4);
+    REQUIRE(scheduler.tag_parallelism("performance") == 1);
+    for (int i = 0; i < 3; ++i) {
+        jobs.start(scheduler, {"performance"});
+    }
+    jobs.run(1);
+    REQUIRE(jobs.max_running_tag == 1);
+}
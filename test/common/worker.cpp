@@ -13,6 +13,8 @@
 
 #include <chrono>
 #include <iostream>
+#include <mutex>
+#include <set>
 #include <thread>
 
 TEST_CASE("The worker is robust to submitting many tasks in a row") {
@@ -34,3 +36,64 @@ TEST_CASE("The worker is robust to submitting many tasks in a row") {
         }
     }
 }
+
+TEST_CASE("The worker reuses threads across tasks") {
+    mk::Worker worker{2};
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    for (size_t i = 0; i < 16; ++i) {
+        worker.call_in_thread(mk::Logger::global(), [&]() {
+            using namespace std::chrono_literals;
+            std::this_thread::sleep_for(10ms);
+            std::unique_lock<std::mutex> _{mutex};
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    while (worker.pending() > 0) {
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(10ms);
+    }
+    auto stats = worker.stats();
+    REQUIRE(stats.completed == 16);
+    REQUIRE(stats.queued == 0);
+    REQUIRE(stats.running == 0);
+    REQUIRE(stats.threads <= 2);
+    REQUIRE(stats.max_wait_time > 0.0);
+    REQUIRE(stats.wait_time >= stats.max_wait_time);
+    std::unique_lock<std::mutex> _{mutex};
+    REQUIRE(ids.size() <= 2);
+}
+
+TEST_CASE("The worker reaps threads that have been idle for too long") {
+    mk::Worker worker{3};
+    worker.set_idle_timeout(0.1);
+    for (size_t i = 0; i < 3; ++i) {
+        worker.call_in_thread(mk::Logger::global(), []() {
+            using namespace std::chrono_literals;
+            std::this_thread::sleep_for(50ms);
+        });
+    }
+    REQUIRE(worker.stats().threads == 3);
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(1s);
+    REQUIRE(worker.stats().threads == 0);
+    REQUIRE(worker.stats().completed == 3);
+}
+
+TEST_CASE("The worker keeps alive min_threads() idle threads") {
+    mk::Worker worker{3};
+    worker.set_idle_timeout(0.1);
+    worker.set_min_threads(1);
+    REQUIRE(worker.min_threads() == 1);
+    for (size_t i = 0; i < 3; ++i) {
+        worker.call_in_thread(mk::Logger::global(), []() {
+            using namespace std::chrono_literals;
+            std::this_thread::sleep_for(50ms);
+        });
+    }
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(1s);
+    REQUIRE(worker.stats().threads == 1);
+    worker.wait_empty_();
+    REQUIRE(worker.stats().threads == 0);
+}
@@ -8,6 +8,10 @@
 
 #include <measurement_kit/ffi.h>
 
+#include <vector>
+
+#include "src/libmeasurement_kit/engine.hpp"
+
 TEST_CASE("mk_nettest_start() works as expected") {
     SECTION("With nullptr settings") {
         auto task = mk_nettest_start(nullptr);
@@ -19,3 +23,46 @@ TEST_CASE("mk_nettest_start() works as expected") {
         REQUIRE(task == nullptr);
     }
 }
+
+TEST_CASE("mk_task_set_parallelism() works as expected") {
+    SECTION("Values smaller than one are treated as one") {
+        mk_task_set_parallelism(-1);
+        REQUIRE(mk::engine::Task::parallelism() == 1);
+        mk_task_set_parallelism(0);
+        REQUIRE(mk::engine::Task::parallelism() == 1);
+    }
+
+    SECTION("Many tasks can run concurrently") {
+        mk_task_set_parallelism(4);
+        REQUIRE(mk::engine::Task::parallelism() == 4);
+        std::vector<mk_unique_task> tasks;
+        for (size_t i = 0; i < 8; ++i) {
+            tasks.emplace_back(mk_nettest_start(R"({"name": "Antani"})"));
+            REQUIRE(tasks.back() != nullptr);
+        }
+        for (auto &task : tasks) {
+            while (!mk_task_is_done(task.get())) {
+                mk_unique_event event{mk_task_wait_for_next_event(task.get())};
+                REQUIRE(event != nullptr);
+            }
+        }
+        mk_task_set_parallelism(1);
+    }
+}
+
+TEST_CASE("mk_task_set_tag_parallelism() works as expected") {
+    SECTION("Performance tasks are limited by default") {
+        REQUIRE(mk::engine::Task::tag_parallelism("performance") == 1);
+    }
+
+    SECTION("With nullptr tag") {
+        mk_task_set_tag_parallelism(nullptr, 7); // should not crash
+    }
+
+    SECTION("We can set and remove a limit") {
+        mk_task_set_tag_parallelism("websites", 2);
+        REQUIRE(mk::engine::Task::tag_parallelism("websites") == 2);
+        mk_task_set_tag_parallelism("websites", 0);
+        REQUIRE(mk::engine::Task::tag_parallelism("websites") == 0);
+    }
+}
@@ -8,6 +8,11 @@
 
 #include "utils.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
 using namespace mk::nettests;
 using namespace mk;
 
@@ -200,3 +205,129 @@ TEST_CASE("Make sure that 'randomize_input' works") {
         REQUIRE(repeat(false, 8) == 9);
     }
 }
+
+class PooledRunnable : public nettests::Runnable {
+  public:
+    PooledRunnable() { supports_reactor_pool = true; }
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    bool main_reactor_used = false;
+    int started = 0;
+
+  protected:
+    void main_with_reactor(SharedPtr<Reactor> r, std::string, Settings,
+            Callback<SharedPtr<nlohmann::json>> cb) override {
+        int count = 0;
+        {
+            // Note: Catch is not thread safe, so check later
+            std::unique_lock<std::mutex> _{mutex};
+            threads.insert(std::this_thread::get_id());
+            main_reactor_used = main_reactor_used || r.get() == reactor.get();
+            count = ++started;
+        }
+        // Measurements started later complete earlier
+        r->call_later(0.2 - 0.015 * count,
+                [=]() { cb(SharedPtr<nlohmann::json>{new nlohmann::json}); });
+    }
+};
+
+TEST_CASE("Make sure that 'reactor_pool_size' works") {
+    PooledRunnable test;
+    std::vector<std::string> inputs;
+    test.reactor = Reactor::make();
+    test.input_filepaths.push_back("./test/fixtures/hosts.txt");
+    test.needs_input = true;
+    test.use_bouncer = false;
+    test.options["no_collector"] = 1;
+    test.options["no_file_report"] = 1;
+    test.options["reactor_pool_size"] = 4;
+    test.options["randomize_input"] = false;
+    test.reactor->run_with_initial_event([&]() {
+        test.entry_cb = [&](std::string s) {
+            // Entries must be processed by the reactor thread
+            REQUIRE(test.threads.count(std::this_thread::get_id()) == 0);
+            nlohmann::json entry = nlohmann::json::parse(s);
+            inputs.push_back(entry["input"]);
+        };
+        test.begin([&](Error) { test.end([&](Error) {}); });
+    });
+    // Entries must be written in input order regardless of completion order
+    REQUIRE((inputs == std::vector<std::string>{"torproject.org", "ooni.nu",
+            "neubot.org", "archive.org", "creativecommons.org",
+            "cyber.law.harvard.edu", "duckduckgo.com", "netflix.com",
+            "nmap.org", "www.emule.com"}));
+    REQUIRE(test.threads.size() > 0);
+    REQUIRE(test.threads.size() <= 4);
+    REQUIRE(!test.main_reactor_used);
+}
+
+class SlowFirstRunnable : public nettests::Runnable {
+  public:
+    SlowFirstRunnable() { supports_reactor_pool = true; }
+
+    std::atomic<int> started{0};
+    int started_when_slow_done = 0;
+
+  protected:
+    void main_with_reactor(SharedPtr<Reactor> r, std::string, Settings,
+            Callback<SharedPtr<nlohmann::json>> cb) override {
+        bool slow = (started++ == 0);
+        r->call_later(slow ? 1.0 : 0.01, [=]() {
+            if (slow) {
+                started_when_slow_done = started;
+            }
+            cb(SharedPtr<nlohmann::json>{new nlohmann::json});
+        });
+    }
+};
+
+TEST_CASE("A slow measurement does not stall the other pool slots") {
+    SlowFirstRunnable test;
+    std::vector<std::string> inputs;
+    test.reactor = Reactor::make();
+    test.input_filepaths.push_back("./test/fixtures/hosts.txt");
+    test.needs_input = true;
+    test.use_bouncer = false;
+    test.options["no_collector"] = 1;
+    test.options["no_file_report"] = 1;
+    test.options["reactor_pool_size"] = 2;
+    test.options["randomize_input"] = false;
+    test.reactor->run_with_initial_event([&]() {
+        test.entry_cb = [&](std::string s) {
+            nlohmann::json entry = nlohmann::json::parse(s);
+            inputs.push_back(entry["input"]);
+        };
+        test.begin([&](Error) { test.end([&](Error) {}); });
+    });
+    // The other slot must have measured all the other inputs meanwhile
+    REQUIRE(test.started_when_slow_done == 10);
+    REQUIRE(inputs.size() == 10);
+    REQUIRE(inputs[0] == "torproject.org");
+}
+
+TEST_CASE("A slow measurement does not grow the reorder buffer forever") {
+    SlowFirstRunnable test;
+    std::vector<std::string> inputs;
+    test.reactor = Reactor::make();
+    test.input_filepaths.push_back("./test/fixtures/hosts.txt");
+    test.needs_input = true;
+    test.use_bouncer = false;
+    test.options["no_collector"] = 1;
+    test.options["no_file_report"] = 1;
+    test.options["reactor_pool_size"] = 2;
+    test.options["parallelism"] = 2;
+    test.options["reactor_pool_max_buffered_entries"] = 3;
+    test.options["randomize_input"] = false;
+    test.reactor->run_with_initial_event([&]() {
+        test.entry_cb = [&](std::string s) {
+            nlohmann::json entry = nlohmann::json::parse(s);
+            inputs.push_back(entry["input"]);
+        };
+        test.begin([&](Error) { test.end([&](Error) {}); });
+    });
+    // The other slot must have stopped once three entries were buffered
+    REQUIRE(test.started_when_slow_done == 4);
+    REQUIRE(inputs.size() == 10);
+    REQUIRE(inputs[0] == "torproject.org");
+}